@@ -0,0 +1,225 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The same workload is built by every example as my_benchmark, so the numbers of
+// the build variants can be compared. Results are printed as "key=value" lines,
+// which are collected by benchmark/run.sh into one table.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "milvus/MilvusClientV2.h"
+
+namespace util {
+void
+CheckStatus(std::string&& msg, const milvus::Status& status) {
+    if (!status.IsOk()) {
+        throw std::runtime_error("Failed to " + msg + ", error: " + status.Message());
+    }
+}
+
+std::vector<float>
+GenerateFloatVector(int dimension) {
+    static std::mt19937 ran(42);
+    std::uniform_real_distribution<float> float_gen(0.0, 1.0);
+    std::vector<float> vector(dimension);
+    for (auto d = 0; d < dimension; ++d) {
+        vector[d] = float_gen(ran);
+    }
+    return vector;
+}
+
+int64_t
+EnvOr(const char* name, int64_t default_value) {
+    const char* value = std::getenv(name);
+    return value == nullptr ? default_value : std::atoll(value);
+}
+
+// wall clock in nanoseconds, comparable with `date +%s%N` of the launching shell
+int64_t
+NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// user + sys CPU time of this process in milliseconds, server time is not included
+double
+CpuMs() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    auto ms = [](const timeval& tv) {
+        return static_cast<double>(tv.tv_sec) * 1e3 + static_cast<double>(tv.tv_usec) / 1e3;
+    };
+    return ms(usage.ru_utime) + ms(usage.ru_stime);
+}
+
+double
+ElapsedMs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void
+PrintLatency(const std::string& name, std::vector<double>& latencies) {
+    if (latencies.empty()) {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        auto index = static_cast<size_t>(p * static_cast<double>(latencies.size() - 1));
+        return latencies[index];
+    };
+    double total = 0;
+    for (auto latency : latencies) {
+        total += latency;
+    }
+    std::cout << name << "_mean_ms=" << total / static_cast<double>(latencies.size()) << std::endl;
+    std::cout << name << "_p50_ms=" << percentile(0.5) << std::endl;
+    std::cout << name << "_p99_ms=" << percentile(0.99) << std::endl;
+}
+}
+
+int
+main(int argc, char* argv[]) {
+  try {
+    const int64_t main_entry_ns = util::NowNs();
+    // BENCH_LAUNCH_NS is set by run.sh to the time right before the process was started
+    const int64_t launch_ns = util::EnvOr("BENCH_LAUNCH_NS", 0);
+
+    const int64_t warmup = util::EnvOr("BENCH_WARMUP", 10);
+    const int64_t iterations = util::EnvOr("BENCH_ITERATIONS", 100);
+    const int64_t batch = util::EnvOr("BENCH_BATCH", 100);
+    const uint32_t dimension = 128;
+
+    auto client = milvus::MilvusClientV2::Create();
+
+    // cold start: process launch to the first successful call on a connected client
+    milvus::ConnectParam connect_param{"localhost", 19530, "root", "Milvus"};
+    auto status = client->Connect(connect_param);
+    util::CheckStatus("connect milvus server", status);
+    milvus::CheckHealthResponse resp_health;
+    status = client->CheckHealth(milvus::CheckHealthRequest(), resp_health);
+    util::CheckStatus("check milvus server healthy", status);
+    const int64_t first_call_ns = util::NowNs();
+
+    if (launch_ns > 0) {
+        std::cout << "main_entry_ms=" << static_cast<double>(main_entry_ns - launch_ns) / 1e6 << std::endl;
+        std::cout << "first_call_ms=" << static_cast<double>(first_call_ns - launch_ns) / 1e6 << std::endl;
+    }
+    if (util::EnvOr("BENCH_STARTUP_ONLY", 0) != 0) {
+        status = client->Disconnect();
+        util::CheckStatus("disconnect to milvus server", status);
+        return 0;
+    }
+
+    const std::string collection_name = "MY_BENCHMARK_COLLECTION";
+    const std::string field_id = "id";
+    const std::string field_embedding = "embedding";
+    status = client->DropCollection(milvus::DropCollectionRequest().WithCollectionName(collection_name));
+
+    milvus::CollectionSchema collection_schema(collection_name);
+    collection_schema.AddField({field_id, milvus::DataType::INT64, "id", true, false});
+    collection_schema.AddField(
+        milvus::FieldSchema(field_embedding, milvus::DataType::FLOAT_VECTOR, "embedding").WithDimension(dimension));
+    status = client->CreateCollection(milvus::CreateCollectionRequest()
+                                          .WithCollectionSchema(std::make_shared<milvus::CollectionSchema>(std::move(collection_schema)))
+                                          .WithConsistencyLevel(milvus::ConsistencyLevel::BOUNDED));
+    util::CheckStatus("create collection " + collection_name, status);
+
+    milvus::IndexDesc index_vector(field_embedding, "", milvus::IndexType::FLAT, milvus::MetricType::L2);
+    status = client->CreateIndex(
+        milvus::CreateIndexRequest().WithCollectionName(collection_name).AddIndex(std::move(index_vector)));
+    util::CheckStatus("create index", status);
+
+    status = client->LoadCollection(
+        milvus::LoadCollectionRequest().WithCollectionName(collection_name).WithReplicaNum(1));
+    util::CheckStatus("load collection " + collection_name, status);
+
+    // client CPU time of the steady-state loops, covers row generation, JSON conversion and protobuf work
+    const double cpu_begin_ms = util::CpuMs();
+
+    // steady-state insert latency, the rows are generated outside of the timed section
+    std::vector<double> insert_latencies;
+    int64_t next_id = 0;
+    for (auto i = 0; i < warmup + iterations; ++i) {
+        milvus::EntityRows rows;
+        for (auto r = 0; r < batch; ++r) {
+            milvus::EntityRow row;
+            row[field_id] = next_id++;
+            row[field_embedding] = util::GenerateFloatVector(dimension);
+            rows.emplace_back(std::move(row));
+        }
+        auto request = milvus::InsertRequest().WithCollectionName(collection_name).WithRowsData(std::move(rows));
+
+        milvus::InsertResponse response;
+        auto begin = std::chrono::steady_clock::now();
+        status = client->Insert(request, response);
+        auto latency = util::ElapsedMs(begin);
+        util::CheckStatus("insert", status);
+        if (i >= warmup) {
+            insert_latencies.push_back(latency);
+        }
+    }
+
+    // steady-state search latency
+    std::vector<double> search_latencies;
+    for (auto i = 0; i < warmup + iterations; ++i) {
+        auto request = milvus::SearchRequest()
+                           .WithCollectionName(collection_name)
+                           .WithLimit(10)
+                           .WithAnnsField(field_embedding)
+                           .AddFloatVector(util::GenerateFloatVector(dimension))
+                           .WithConsistencyLevel(milvus::ConsistencyLevel::EVENTUALLY);
+
+        milvus::SearchResponse response;
+        auto begin = std::chrono::steady_clock::now();
+        status = client->Search(request, response);
+        auto latency = util::ElapsedMs(begin);
+        util::CheckStatus("search", status);
+        if (i >= warmup) {
+            search_latencies.push_back(latency);
+        }
+    }
+
+    const double cpu_end_ms = util::CpuMs();
+
+    status = client->DropCollection(milvus::DropCollectionRequest().WithCollectionName(collection_name));
+    util::CheckStatus("drop collection " + collection_name, status);
+    status = client->Disconnect();
+    util::CheckStatus("disconnect to milvus server", status);
+
+    util::PrintLatency("insert", insert_latencies);
+    util::PrintLatency("search", search_latencies);
+    std::cout << "client_cpu_ms=" << cpu_end_ms - cpu_begin_ms << std::endl;
+
+    // ru_maxrss is in kilobytes on Linux
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "peak_rss_kb=" << usage.ru_maxrss << std::endl;
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
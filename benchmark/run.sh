@@ -0,0 +1,173 @@
+#!/usr/bin/env bash
+
+# Licensed to the LF AI & Data foundation under one
+# or more contributor license agreements. See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership. The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License. You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Build every example variant with my_benchmark and write one comparison table.
+# For each variant it measures:
+#   - size of my_benchmark and of the non-system shared libraries it loads
+#   - dynamic loader time and relocations (LD_DEBUG=statistics), median of RUNS startups
+#   - launch -> main() and launch -> first successful call on a connected client,
+#     median of RUNS startups
+#   - peak RSS, steady-state Insert/Search latency and the client CPU time of the steady-state
+#     loops of one full run
+# A Milvus server must be listening on localhost:19530, all the variants use the same one.
+
+set -e
+
+cd "$(dirname "$0")"
+
+VARIANTS="${VARIANTS:-without-conan:ON without-conan:OFF conan-for-dependencies:OFF conan-for-dependencies:ON conan-managed:OFF conan-managed:ON}"
+RUNS="${RUNS:-5}"
+RESULT_FILE="${RESULT_FILE:-results.md}"
+export BUILD_TYPE="${BUILD_TYPE:-Release}"
+
+# the launch time is taken from EPOCHREALTIME right before exec, without forking
+if [[ -z "${EPOCHREALTIME}" ]]; then
+  echo "run.sh needs bash 5 or newer (EPOCHREALTIME)" >&2
+  exit 1
+fi
+
+# check once, before building anything, that the page cache can be dropped
+if [[ "${DROP_CACHES}" == "1" && ! -w /proc/sys/vm/drop_caches ]]; then
+  echo "DROP_CACHES=1 needs write access to /proc/sys/vm/drop_caches, run as root or without DROP_CACHES" >&2
+  exit 1
+fi
+
+# run a command with the runtime environment of the variant, conanrun.sh sets LD_LIBRARY_PATH
+# for shared-library builds, same as "make run".
+# With STAMP_LAUNCH=1, BENCH_LAUNCH_NS is taken right before exec, so the environment setup
+# of the conan variants is not charged to their startup time.
+run_in_variant() {
+  local build_dir=$1
+  shift
+  (
+    if [[ -f ${build_dir}/conanrun.sh ]]; then
+      source ${build_dir}/conanrun.sh
+    fi
+    export GRPC_VERBOSITY=ERROR GLOG_minloglevel=3
+    if [[ "${STAMP_LAUNCH}" == "1" ]]; then
+      export BENCH_LAUNCH_NS="${EPOCHREALTIME//[.,]/}000"
+    fi
+    exec "$@"
+  )
+}
+
+# drop the page cache before a startup with DROP_CACHES=1, otherwise the startups are warm
+drop_caches() {
+  if [[ "${DROP_CACHES}" == "1" ]]; then
+    sync
+    echo 3 > /proc/sys/vm/drop_caches
+  fi
+}
+
+value_of() {
+  grep "^$1=" | tail -n 1 | cut -d= -f2
+}
+
+median() {
+  sort -n | awk '{ v[NR] = $1 } END { if (NR > 0) print v[int((NR + 1) / 2)] }'
+}
+
+mb() {
+  awk -v b=$1 'BEGIN { printf "%.1f", b / 1048576 }'
+}
+
+ROWS=""
+for variant in ${VARIANTS}; do
+  example=${variant%%:*}
+  shared=${variant##*:}
+  build_dir_name="cmake_build_bench_shared_$(echo ${shared} | tr 'A-Z' 'a-z')"
+  build_dir="$(pwd)/../${example}/${build_dir_name}"
+  log="$(pwd)/build_${example}_${shared}.log"
+
+  echo "Building ${example} (SHARED=${shared}, BUILD_TYPE=${BUILD_TYPE}), log: ${log} ..."
+  if ! (cd ../${example} && BUILD_OUTPUT_DIR=${build_dir_name} SHARED=${shared} BENCHMARK=ON bash build.sh) >${log} 2>&1; then
+    echo "Failed to build ${example} (SHARED=${shared})"
+    ROWS="${ROWS}| ${example} | ${shared} | build failed | | | | | | | | | | | |\n"
+    continue
+  fi
+  binary=${build_dir}/my_benchmark
+
+  # steady state, also tells early whether the variant runs at all (server reachable, libraries found)
+  echo "Running ${example} (SHARED=${shared}) ..."
+  if ! steady=$(run_in_variant ${build_dir} ${binary}); then
+    echo "Failed to run ${example} (SHARED=${shared})"
+    ROWS="${ROWS}| ${example} | ${shared} | run failed | | | | | | | | | | | |\n"
+    continue
+  fi
+
+  # sizes
+  binary_size=$(stat -L -c %s ${binary})
+  libs_size=0
+  for lib in $(run_in_variant ${build_dir} ldd ${binary} | awk '/=> \// { print $3 }' | grep -v -E '^/(usr/)?lib(32|64)?/'); do
+    libs_size=$((libs_size + $(stat -L -c %s ${lib})))
+  done
+
+  # dynamic loader and startup, median of RUNS runs each, loader statistics are taken in separate
+  # runs because LD_DEBUG slows the startup down
+  loader_cycles=""
+  relocations=""
+  main_entry=""
+  first_call=""
+  failed=0
+  for ((i = 0; i < RUNS; i++)); do
+    drop_caches
+    if ! loader=$(BENCH_STARTUP_ONLY=1 LD_DEBUG=statistics run_in_variant ${build_dir} ${binary} 2>&1 >/dev/null); then
+      failed=1
+      break
+    fi
+    loader_cycles="${loader_cycles}$(echo "${loader}" | awk '/total startup time in dynamic loader/ { print $(NF - 1); exit }')\n"
+    relocations="${relocations}$(echo "${loader}" | awk '/ number of relocations:/ { print $NF; exit }')\n"
+
+    drop_caches
+    if ! output=$(BENCH_STARTUP_ONLY=1 STAMP_LAUNCH=1 run_in_variant ${build_dir} ${binary}); then
+      failed=1
+      break
+    fi
+    main_entry="${main_entry}$(echo "${output}" | value_of main_entry_ms)\n"
+    first_call="${first_call}$(echo "${output}" | value_of first_call_ms)\n"
+  done
+  if [[ ${failed} == 1 ]]; then
+    echo "Failed to start ${example} (SHARED=${shared})"
+    ROWS="${ROWS}| ${example} | ${shared} | run failed | | | | | | | | | | | |\n"
+    continue
+  fi
+  loader_cycles=$(printf "${loader_cycles}" | median)
+  relocations=$(printf "${relocations}" | median)
+  main_entry=$(printf "${main_entry}" | median)
+  first_call=$(printf "${first_call}" | median)
+
+  ROWS="${ROWS}| ${example} | ${shared} | $(mb ${binary_size}) | $(mb ${libs_size}) \
+| $(awk -v c=${loader_cycles:-0} 'BEGIN { printf "%.1f", c / 1e6 }') | ${relocations} \
+| ${main_entry} | ${first_call} \
+| $(awk -v k=$(echo "${steady}" | value_of peak_rss_kb) 'BEGIN { printf "%.1f", k / 1024 }') \
+| $(echo "${steady}" | value_of insert_p50_ms) | $(echo "${steady}" | value_of insert_p99_ms) \
+| $(echo "${steady}" | value_of search_p50_ms) | $(echo "${steady}" | value_of search_p99_ms) \
+| $(echo "${steady}" | value_of client_cpu_ms) |\n"
+done
+
+{
+  echo "# Build variant comparison"
+  echo
+  echo "BUILD_TYPE=${BUILD_TYPE}, loader statistics and startup times are the median of ${RUNS} runs$([[ "${DROP_CACHES}" == "1" ]] && echo " with the page cache dropped"), latencies are in ms."
+  echo
+  echo "| Example | SHARED | my_benchmark MB | Non-system .so MB | Loader Mcycles | Relocations | Launch to main ms | Launch to first call ms | Peak RSS MB | Insert p50 | Insert p99 | Search p50 | Search p99 | Client CPU ms |"
+  echo "|---|---|---|---|---|---|---|---|---|---|---|---|---|---|"
+  printf "${ROWS}"
+} >${RESULT_FILE}
+
+cat ${RESULT_FILE}
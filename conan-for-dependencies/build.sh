@@ -16,11 +16,14 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
-BUILD_OUTPUT_DIR="cmake_build"
+BUILD_OUTPUT_DIR="${BUILD_OUTPUT_DIR:-cmake_build}"
 
 # Set build type to match Conan profile (Release)
 BUILD_TYPE="${BUILD_TYPE:-Release}"
 SHARED="${SHARED:-OFF}"
+LTO="${LTO:-OFF}"
+PGO="${PGO:-}"
+BENCHMARK="${BENCHMARK:-OFF}"
 
 # Map SHARED flag to Conan shared options for transitive deps.
 if [[ "${SHARED}" == "ON" ]]; then
@@ -51,6 +54,9 @@ make rebuild_cache >/dev/null 2>&1
 
 CMAKE_CMD="cmake \
 -DCMAKE_BUILD_TYPE=${BUILD_TYPE} \
+-DENABLE_LTO=${LTO} \
+-DPGO=${PGO} \
+-DBUILD_BENCHMARK=${BENCHMARK} \
 -DCMAKE_TOOLCHAIN_FILE=conan_toolchain.cmake \
 -DBUILD_SHARED_LIBS=${SHARED} \
 -DBUILD_FROM_CONAN=ON \
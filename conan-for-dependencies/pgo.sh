@@ -0,0 +1,82 @@
+#!/usr/bin/env bash
+
+# Licensed to the LF AI & Data foundation under one
+# or more contributor license agreements. See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership. The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License. You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Build an optimized Release my_program with LTO + PGO and report the speedup:
+#   1. plain Release build, measure the workload
+#   2. LTO + instrumented build, run the workload and my_program once to collect the profile
+#   3. LTO + profile-optimized build, measure the workload again
+# The workload is my_benchmark (see ../benchmark), built with the same flags as my_program.
+# my_program is run in the training pass too, so its own code gets a profile as well.
+# Its steady-state Insert/Search loops exercise the client row conversion and protobuf
+# serialization, and the speedup is computed on the client user + sys CPU time of those
+# loops, because the wall time is dominated by the server.
+# A Milvus server must be listening on localhost:19530 (a local milvus standalone is enough).
+
+set -e -o pipefail
+
+BUILD_OUTPUT_DIR="cmake_build"
+PGO_PROFILE_DIR="$(pwd)/${BUILD_OUTPUT_DIR}/pgo-profile"
+RUNS="${RUNS:-5}"
+
+export BUILD_TYPE=Release
+export BENCHMARK=ON
+
+# run one of the built executables
+run_executable() {
+  # conanrun.sh sets LD_LIBRARY_PATH for shared-library builds, same as "make run"
+  bash -c "source ${BUILD_OUTPUT_DIR}/conanrun.sh && GRPC_VERBOSITY=ERROR GLOG_minloglevel=3 ${BUILD_OUTPUT_DIR}/$1"
+}
+
+# average client CPU time of the workload in milliseconds, stops the script if any run fails
+measure_workload() {
+  local output value values=""
+  for ((i = 0; i < RUNS; i++)); do
+    output=$(run_executable my_benchmark) || exit 1
+    value=$(echo "${output}" | grep "^client_cpu_ms=" | cut -d= -f2)
+    if [ -z "${value}" ]; then
+      echo "my_benchmark did not report client_cpu_ms" >&2
+      exit 1
+    fi
+    values+="${value}"$'\n'
+  done
+  echo -n "${values}" | awk '{ total += $1 } END { printf "%.1f", total / NR }'
+}
+
+echo "Building baseline (Release) ..."
+LTO=OFF PGO= bash build.sh
+BASELINE_MS=$(measure_workload)
+
+echo "Building instrumented binary (Release, LTO, PGO=GENERATE) ..."
+rm -fr ${PGO_PROFILE_DIR}
+LTO=ON PGO=GENERATE bash build.sh
+echo "Training on my_benchmark and my_program ..."
+run_executable my_benchmark >/dev/null
+run_executable my_program >/dev/null
+
+# clang writes raw profiles that must be merged before use, gcc reads its .gcda files directly
+if ls ${PGO_PROFILE_DIR}/*.profraw >/dev/null 2>&1; then
+  llvm-profdata merge -output=${PGO_PROFILE_DIR}/default.profdata ${PGO_PROFILE_DIR}/*.profraw
+fi
+
+echo "Building optimized binary (Release, LTO, PGO=USE) ..."
+LTO=ON PGO=USE bash build.sh
+OPTIMIZED_MS=$(measure_workload)
+
+echo "Baseline:  ${BASELINE_MS} ms client CPU per run (average of ${RUNS})"
+echo "LTO + PGO: ${OPTIMIZED_MS} ms client CPU per run (average of ${RUNS})"
+awk -v b=${BASELINE_MS} -v o=${OPTIMIZED_MS} 'BEGIN { if (o > 0) printf "Speedup:   %.2fx\n", b / o }'
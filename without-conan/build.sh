@@ -18,9 +18,13 @@
 
 # export LD_LIBRARY_PATH=./libs/grpc_install/lib
 
-BUILD_OUTPUT_DIR="cmake_build"
+BUILD_OUTPUT_DIR="${BUILD_OUTPUT_DIR:-cmake_build}"
 BUILD_TYPE="${BUILD_TYPE:-Debug}"
 SHARED="${SHARED:-ON}"
+LTO="${LTO:-OFF}"
+PGO="${PGO:-}"
+BENCHMARK="${BENCHMARK:-OFF}"
+MEM_PROFILE="${MEM_PROFILE:-OFF}"
 
 if [[ ! -d ${BUILD_OUTPUT_DIR} ]]; then
   mkdir ${BUILD_OUTPUT_DIR}
@@ -34,9 +38,13 @@ make rebuild_cache >/dev/null 2>&1
 
 CMAKE_CMD="cmake \
 -DCMAKE_BUILD_TYPE=${BUILD_TYPE} \
+-DENABLE_LTO=${LTO} \
+-DPGO=${PGO} \
+-DBUILD_BENCHMARK=${BENCHMARK} \
 -DGRPC_PATH=${GRPC_PATH} \
 -DBUILD_SHARED_LIBS=${SHARED} \
 -DBUILD_FROM_CONAN=OFF \
+-DMEM_PROFILE=${MEM_PROFILE} \
 ../"
 echo ${CMAKE_CMD}
 ${CMAKE_CMD}
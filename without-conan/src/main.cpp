@@ -14,11 +14,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdlib>
 #include <iostream>
 #include <random>
 #include <stdexcept>
 #include <string>
 
+#include "mem_profile.h"
 #include "milvus/MilvusClientV2.h"
 
 namespace util {
@@ -42,6 +44,17 @@ GenerateFloatVector(int dimension) {
     }
     return std::move(vector);
 }
+
+// print the memory profile, fail if MEM_PROFILE_MAX_BYTES_PER_ROW is set and a row-scaled phase exceeds it
+int
+CheckMemoryProfile() {
+    memprof::Report(std::cout);
+    const char* max_bytes_per_row = std::getenv("MEM_PROFILE_MAX_BYTES_PER_ROW");
+    if (max_bytes_per_row != nullptr && !memprof::CheckBudget(std::atof(max_bytes_per_row), std::cerr)) {
+        return 1;
+    }
+    return 0;
+}
 }
 
 int
@@ -50,6 +63,34 @@ main(int argc, char* argv[]) {
     printf("Example start...\n");
     printf("[Include milvus-sdk-capp and its dependencies via CMake, very slow to rebuild after clean]\n");
 
+    // names
+    const std::string collection_name = "MY_PROGRAM_COLLECTION";
+    const std::string field_id = "user_id";
+    const std::string field_name = "user_name";
+    const std::string field_age = "user_age";
+    const std::string field_embedding = "user_face";
+    const uint32_t dimension = 128;
+
+    // prepare some rows to insert
+    const int64_t row_count = 1000;
+    milvus::EntityRows rows;
+    {
+        memprof::Phase phase("generate", row_count);
+        for (auto i = 0; i < row_count; ++i) {
+            milvus::EntityRow row;
+            row[field_id] = i;
+            row[field_name] = "user_" + std::to_string(i);
+            row[field_age] = i % 100;
+            row[field_embedding] = util::GenerateFloatVector(dimension);
+            rows.emplace_back(std::move(row));
+        }
+    }
+
+    // with MEM_PROFILE_OFFLINE only the row generation is measured, it doesn't need a milvus server
+    if (memprof::Enabled() && std::getenv("MEM_PROFILE_OFFLINE") != nullptr) {
+        return util::CheckMemoryProfile();
+    }
+
     auto client = milvus::MilvusClientV2::Create();
 
     // connect
@@ -85,16 +126,8 @@ main(int argc, char* argv[]) {
     std::cout << "The CPP SDK version is: " << version << std::endl;
 
     // drop the collection if it exists
-    const std::string collection_name = "MY_PROGRAM_COLLECTION";
     status = client->DropCollection(milvus::DropCollectionRequest().WithCollectionName(collection_name));
 
-    // names
-    const std::string field_id = "user_id";
-    const std::string field_name = "user_name";
-    const std::string field_age = "user_age";
-    const std::string field_embedding = "user_face";
-    const uint32_t dimension = 128;
-
     // collection schema, create collection
     milvus::CollectionSchema collection_schema(collection_name);
     collection_schema.AddField({field_id, milvus::DataType::INT64, "user id", true, false});
@@ -128,21 +161,14 @@ main(int argc, char* argv[]) {
                                         .WithReplicaNum(1));
     util::CheckStatus("load collection " + collection_name, status);
 
-    // insert some rows
-    const int64_t row_count = 1000;
-    milvus::EntityRows rows;
-    for (auto i = 0; i < row_count; ++i) {
-        milvus::EntityRow row;
-        row[field_id] = i;
-        row[field_name] = "user_" + std::to_string(i);
-        row[field_age] = i % 100;
-        row[field_embedding] = util::GenerateFloatVector(dimension);
-        rows.emplace_back(std::move(row));
-    }
-
+    // insert the rows, the SDK converts them to column-based data inside Insert(), the temporary
+    // request releases the rows right after the call
     milvus::InsertResponse resp_insert;
-    status = client->Insert(
-        milvus::InsertRequest().WithCollectionName(collection_name).WithRowsData(std::move(rows)), resp_insert);
+    {
+        memprof::Phase phase("insert", row_count);
+        status = client->Insert(
+            milvus::InsertRequest().WithCollectionName(collection_name).WithRowsData(std::move(rows)), resp_insert);
+    }
     util::CheckStatus("insert", status);
     std::cout << "Successfully insert " << resp_insert.Results().InsertCount() << " rows." << std::endl;
 
@@ -155,7 +181,10 @@ main(int argc, char* argv[]) {
                            .WithConsistencyLevel(milvus::ConsistencyLevel::STRONG);
 
         milvus::QueryResponse response;
-        status = client->Query(request, response);
+        {
+            memprof::Phase phase("query count");
+            status = client->Query(request, response);
+        }
         util::CheckStatus("query count(*)", status);
         std::cout << "count(*) = " << response.Results().GetRowCount() << std::endl;
     }
@@ -171,11 +200,18 @@ main(int argc, char* argv[]) {
 
         std::cout << "\nQuery with filter: " << request.Filter() << std::endl;
         milvus::QueryResponse response;
-        status = client->Query(request, response);
+        {
+            memprof::Phase phase("query filter");
+            status = client->Query(request, response);
+        }
         util::CheckStatus("query", status);
 
         milvus::EntityRows output_rows;
-        status = response.Results().OutputRows(output_rows);
+        {
+            memprof::Phase phase("query decode", 0);
+            status = response.Results().OutputRows(output_rows);
+            phase.SetRows(static_cast<int64_t>(output_rows.size()));
+        }
         util::CheckStatus("get output rows", status);
         std::cout << "Query results:" << std::endl;
         for (const auto& row : output_rows) {
@@ -198,7 +234,10 @@ main(int argc, char* argv[]) {
 
         std::cout << "\nSearch with filter: " << request.Filter() << std::endl;
         milvus::SearchResponse response;
-        status = client->Search(request, response);
+        {
+            memprof::Phase phase("search");
+            status = client->Search(request, response);
+        }
         util::CheckStatus("search", status);
 
         auto search_results = response.Results();
@@ -207,7 +246,11 @@ main(int argc, char* argv[]) {
             std::cout << "Result of the first target vector:" << std::endl;
             const auto& result = search_results.Results().at(0);
             milvus::EntityRows output_rows;
-            status = result.OutputRows(output_rows);
+            {
+                memprof::Phase phase("search decode", 0);
+                status = result.OutputRows(output_rows);
+                phase.SetRows(static_cast<int64_t>(output_rows.size()));
+            }
             util::CheckStatus("get output rows", status);
             for (const auto& row : output_rows) {
                 std::cout << "\t" << row << std::endl;
@@ -229,7 +272,8 @@ main(int argc, char* argv[]) {
 
     status = client->Disconnect();
     util::CheckStatus("disconnect to milvus server", status);
-    return 0;
+
+    return util::CheckMemoryProfile();
   } catch (const std::exception& e) {
     std::cerr << e.what() << std::endl;
     return 1;
@@ -0,0 +1,386 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mem_profile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+std::atomic<uint64_t> g_alloc_count{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+
+inline void
+CountAlloc(std::size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+}
+
+#if defined(MILVUS_EXAMPLE_MEM_PROFILE) && defined(__GLIBC__)
+// With glibc the C allocator itself is replaced, forwarding to the __libc_* entry points. This counts
+// everything that allocates from the heap, including gRPC core (gpr_malloc), protobuf arenas and the
+// default operator new (aligned or not), no matter whether they are linked statically or dynamically.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void*
+malloc(size_t size) {
+    CountAlloc(size);
+    return __libc_malloc(size);
+}
+
+void*
+calloc(size_t count, size_t size) {
+    CountAlloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+void*
+realloc(void* ptr, size_t size) {
+    CountAlloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+void*
+memalign(size_t alignment, size_t size) {
+    CountAlloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+void*
+aligned_alloc(size_t alignment, size_t size) {
+    CountAlloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (alignment == 0 || alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    CountAlloc(size);
+    void* result = __libc_memalign(alignment, size);
+    if (result == nullptr) {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+}
+#elif defined(MILVUS_EXAMPLE_MEM_PROFILE)
+// Without glibc only the C++ allocations are counted by replacing the global operator new/delete,
+// allocations made with malloc() directly (e.g. gpr_malloc in gRPC core) are not included.
+namespace {
+void*
+CountedAlloc(std::size_t size, std::size_t alignment) {
+    CountAlloc(size);
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size == 0 ? 1 : size);
+    } else if (posix_memalign(&ptr, alignment, size == 0 ? 1 : size) != 0) {
+        ptr = nullptr;
+    }
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+}
+
+void*
+operator new(std::size_t size) {
+    return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+void*
+operator new[](std::size_t size) {
+    return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+void*
+operator new(std::size_t size, std::align_val_t alignment) {
+    return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void*
+operator new[](std::size_t size, std::align_val_t alignment) {
+    return CountedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void
+operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+namespace {
+// read the resident set size from /proc/self/statm, return 0 if it is not available(non-Linux)
+uint64_t
+CurrentRss() {
+    static const long page_size = sysconf(_SC_PAGESIZE);
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    char buf[128] = {0};
+    auto len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) {
+        return 0;
+    }
+    unsigned long long size = 0, resident = 0;
+    if (sscanf(buf, "%llu %llu", &size, &resident) != 2) {
+        return 0;
+    }
+    return static_cast<uint64_t>(resident) * static_cast<uint64_t>(page_size);
+}
+
+// samples RSS every millisecond in a background thread, keeps the high-water mark since the last Reset()
+class RssSampler {
+ public:
+    ~RssSampler() {
+        stop_.store(true);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    uint64_t
+    Reset() {
+        std::call_once(started_, [this] { thread_ = std::thread([this] { Run(); }); });
+        auto rss = CurrentRss();
+        peak_.store(rss);
+        return rss;
+    }
+
+    uint64_t
+    Peak() {
+        Sample();
+        return peak_.load();
+    }
+
+ private:
+    void
+    Run() {
+        while (!stop_.load()) {
+            Sample();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void
+    Sample() {
+        auto rss = CurrentRss();
+        auto peak = peak_.load();
+        while (rss > peak && !peak_.compare_exchange_weak(peak, rss)) {
+        }
+    }
+
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> peak_{0};
+    std::once_flag started_;
+    std::thread thread_;
+};
+
+struct PhaseRecord {
+    std::string name;
+    bool row_scaled = false;
+    uint64_t calls = 0;
+    int64_t rows = 0;
+    uint64_t alloc_count = 0;
+    uint64_t alloc_bytes = 0;
+    int64_t rss_delta = 0;
+    uint64_t rss_peak = 0;
+};
+
+std::mutex g_records_mutex;
+std::vector<PhaseRecord> g_records;
+
+RssSampler&
+Sampler() {
+    static RssSampler sampler;
+    return sampler;
+}
+
+// a row-scaled phase that handled no rows, e.g. an empty result, has no meaningful bytes-per-row
+bool
+NoRows(const PhaseRecord& record) {
+    return record.row_scaled && record.rows == 0;
+}
+
+// bytes per row for the row-scaled phases, bytes per call for the others
+double
+BytesPerUnit(const PhaseRecord& record) {
+    auto units = record.row_scaled ? record.rows : static_cast<int64_t>(record.calls);
+    return static_cast<double>(record.alloc_bytes) / static_cast<double>(std::max<int64_t>(units, 1));
+}
+}
+
+namespace memprof {
+
+bool
+Enabled() {
+#ifdef MILVUS_EXAMPLE_MEM_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+Phase::Phase(std::string name) : Phase(std::move(name), 0) {
+    row_scaled_ = false;
+}
+
+Phase::Phase(std::string name, int64_t rows) : name_(std::move(name)), row_scaled_(true), rows_(rows) {
+    if (!Enabled()) {
+        return;
+    }
+    rss_begin_ = Sampler().Reset();
+    count_begin_ = g_alloc_count.load(std::memory_order_relaxed);
+    bytes_begin_ = g_alloc_bytes.load(std::memory_order_relaxed);
+}
+
+Phase::~Phase() {
+    if (!Enabled()) {
+        return;
+    }
+    auto count = g_alloc_count.load(std::memory_order_relaxed) - count_begin_;
+    auto bytes = g_alloc_bytes.load(std::memory_order_relaxed) - bytes_begin_;
+    auto rss_peak = Sampler().Peak();
+    auto rss_delta = static_cast<int64_t>(CurrentRss()) - static_cast<int64_t>(rss_begin_);
+
+    std::lock_guard<std::mutex> lock(g_records_mutex);
+    auto it = std::find_if(g_records.begin(), g_records.end(),
+                           [this](const PhaseRecord& record) { return record.name == name_; });
+    if (it == g_records.end()) {
+        g_records.push_back(PhaseRecord{name_, row_scaled_});
+        it = std::prev(g_records.end());
+    }
+    it->calls++;
+    it->rows += rows_;
+    it->alloc_count += count;
+    it->alloc_bytes += bytes;
+    it->rss_delta += rss_delta;
+    it->rss_peak = std::max(it->rss_peak, rss_peak);
+}
+
+void
+Phase::SetRows(int64_t rows) {
+    rows_ = rows;
+}
+
+void
+Report(std::ostream& os) {
+    if (!Enabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_records_mutex);
+    os << "\nMemory profile per phase:" << std::endl;
+    os << std::left << std::setw(16) << "phase" << std::right << std::setw(8) << "calls" << std::setw(10) << "rows"
+       << std::setw(12) << "allocs" << std::setw(16) << "bytes" << std::setw(16) << "bytes/row(call)" << std::setw(14)
+       << "rss delta KB" << std::setw(14) << "rss peak KB" << std::endl;
+    for (const auto& record : g_records) {
+        std::string rows = record.row_scaled ? std::to_string(record.rows) : "-";
+        std::string unit = record.row_scaled ? "" : " (call)";
+        std::ostringstream bytes_per_unit;
+        if (NoRows(record)) {
+            bytes_per_unit << "-";
+        } else {
+            bytes_per_unit << std::fixed << std::setprecision(1) << BytesPerUnit(record) << unit;
+        }
+        os << std::left << std::setw(16) << record.name << std::right << std::setw(8) << record.calls
+           << std::setw(10) << rows << std::setw(12) << record.alloc_count << std::setw(16) << record.alloc_bytes
+           << std::setw(16) << bytes_per_unit.str() << std::setw(14) << record.rss_delta / 1024 << std::setw(14)
+           << record.rss_peak / 1024 << std::endl;
+    }
+}
+
+bool
+CheckBudget(double max_bytes_per_row, std::ostream& os) {
+    if (!Enabled()) {
+        return true;
+    }
+    bool ok = true;
+    std::lock_guard<std::mutex> lock(g_records_mutex);
+    for (const auto& record : g_records) {
+        if (!record.row_scaled || NoRows(record)) {
+            continue;
+        }
+        auto bytes_per_row = BytesPerUnit(record);
+        if (bytes_per_row > max_bytes_per_row) {
+            os << "Phase '" << record.name << "' allocated " << bytes_per_row << " bytes per row, exceeds the budget "
+               << max_bytes_per_row << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+}  // namespace memprof
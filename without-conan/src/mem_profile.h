@@ -0,0 +1,87 @@
+// Licensed to the LF AI & Data foundation under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership. The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace memprof {
+
+/**
+ * @brief Returns true when my_program was built with MEM_PROFILE=ON, i.e. the counting allocator
+ * hook is installed: malloc and friends with glibc, the global operator new/delete elsewhere.
+ * Otherwise all the functions below are cheap no-ops.
+ */
+bool
+Enabled();
+
+/**
+ * @brief Measures one phase of the workflow: allocation count, allocated bytes, RSS delta and
+ * the peak RSS sampled while the phase was running. Phases with the same name are accumulated.
+ * Note that the allocation counters are process-wide, so allocations from gRPC threads running
+ * concurrently are included.
+ */
+class Phase {
+ public:
+    /**
+     * @brief A per-call phase, e.g. an RPC returning a handful of rows. Its cost is mostly fixed
+     * overhead, so it is reported per call and not checked against the bytes-per-row budget.
+     */
+    explicit Phase(std::string name);
+
+    /**
+     * @brief A row-scaled phase, its allocated bytes are divided by rows and checked by CheckBudget().
+     */
+    Phase(std::string name, int64_t rows);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase&
+    operator=(const Phase&) = delete;
+
+    /**
+     * @brief Update the number of rows handled by this phase, used to compute bytes-per-row.
+     * Useful when the row count is only known at the end, e.g. the number of returned rows.
+     */
+    void
+    SetRows(int64_t rows);
+
+ private:
+    std::string name_;
+    bool row_scaled_{false};
+    int64_t rows_{0};
+    uint64_t count_begin_{0};
+    uint64_t bytes_begin_{0};
+    uint64_t rss_begin_{0};
+};
+
+/**
+ * @brief Print the per-phase table collected so far.
+ */
+void
+Report(std::ostream& os);
+
+/**
+ * @brief Check every row-scaled phase against a bytes-per-row budget, print the offending phases.
+ * Phases that handled no rows are skipped.
+ * @return false if any row-scaled phase allocated more than max_bytes_per_row bytes per row.
+ */
+bool
+CheckBudget(double max_bytes_per_row, std::ostream& os);
+
+}  // namespace memprof